@@ -67,7 +67,43 @@ public:
 	// max allowed value. (sanity check)
 	// 2^36; update this in approx 2,400,000 years
 	static const bigint MAX_VALUE = 68719476736L;
-	 
+
+private:
+	// decimal forms of the limits above, for Classify's digit comparisons.
+	// checked against the integer values in ClassifyToken.
+	
+	// MAX_VALUE
+	static constexpr const char *MaxValueDigits() { 
+		return "68719476736"; 
+	}
+	// STEAMID64_BASE
+	static constexpr const char *SteamID64BaseDigits() { 
+		return "76561197960265728"; 
+	}
+	// STEAMID64_BASE + MAX_VALUE
+	static constexpr const char *SteamID64MaxDigits() { 
+		return "76561266679742464"; 
+	}
+	// largest Z in STEAM_X:0:Z, MAX_VALUE / 2
+	static constexpr const char *SteamID32EvenMaxDigits() { 
+		return "34359738368"; 
+	}
+	// largest Z in STEAM_X:1:Z, (MAX_VALUE - 1) / 2
+	static constexpr const char *SteamID32OddMaxDigits() { 
+		return "34359738367"; 
+	}
+	// largest negative S32 magnitude, 2^32 - 1 (S32 wraps at 2^32)
+	static constexpr const char *S32NegativeMaxDigits() { 
+		return "4294967295"; 
+	}
+	
+	// compile-time conversion of a digit string, for the limit checks.
+	static constexpr bigint DigitsValue( const char *str, bigint value = 0 ) {
+		return *str ? DigitsValue( str + 1, value * 10 + (*str - '0') ) 
+					: value;
+	}
+
+public:
 	/** -----------------------------------------------------------------------
 	 * Parse a Steam ID.
 	 *
@@ -266,6 +302,75 @@ public:
 		return !!option;
 	}
 
+	// Classify() bit for full profile URLs, which have no Formats entry.
+	static const uint PROFILE_URL = 1u << 6;
+
+	/** -----------------------------------------------------------------------
+	 * Result of Classify().
+	 */
+	struct Classification {
+		uint formats;	// FormatBit() mask of the formats that matched, 
+						// plus PROFILE_URL.
+		bool valid;		// true if Parse( input, Formats::AUTO, detect_raw )
+						// would return a SteamID, except where Classify
+						// is stricter (see Classify).
+	};
+
+	/** -----------------------------------------------------------------------
+	 * Get the Classify() bit for a format.
+	 */
+	static uint FormatBit( Formats format ) {
+		return 1u << (uint)format;
+	}
+
+	/** -----------------------------------------------------------------------
+	 * Check which formats an input is in without converting it.
+	 *
+	 * Formats are tested the way Parse's auto-detection tests them: 
+	 * STEAMID32, STEAMID64, STEAMID3 and profile URLs on the trimmed input,
+	 * S32 and RAW on the input as-is. A format only matches if its value
+	 * is in range, which is checked on the digits by length and lexical
+	 * comparison instead of converting them.
+	 *
+	 * STEAMID32 matching is stricter than Parse: only plain digits may 
+	 * follow "STEAM_X:Y:". Parse hands that part to std::stoll, which also
+	 * takes leading whitespace, a sign and trailing junk (e.g. 
+	 * "STEAM_1:0: 5", "STEAM_1:0:+5", "STEAM_0:1:-0", "STEAM_1:0:5x").
+	 *
+	 * Embedded NULs are also rejected in every format. Parse's digit check 
+	 * and std::stoll both stop at a '\0', so Parse accepts e.g. 
+	 * "[U:1:4\0x]" or "76561198069264171\0junk".
+	 *
+	 * @param input      Input to classify.
+	 * @param detect_raw Whether S32/RAW matches make the input valid. The 
+	 *                   S32 and RAW bits are reported either way.
+	 *                   Default option set with ParseRawDefault.
+	 *
+	 * @returns Format mask and validity flag.
+	 */
+	static Classification Classify( const std::string &input,
+									int detect_raw = ParseRawDefault() ) {
+		return ClassifyToken( input.data(), input.size(), !!detect_raw );
+	}
+
+	/** -----------------------------------------------------------------------
+	 * Classify an array of inputs.
+	 *
+	 * @param inputs     Inputs to classify.
+	 * @param count      Number of entries in inputs.
+	 * @param results    Output, receives count entries.
+	 * @param detect_raw See Classify.
+	 */
+	static void ClassifyBatch( const std::string *inputs, size_t count,
+							   Classification *results,
+							   int detect_raw = ParseRawDefault() ) {
+		bool raw = !!detect_raw;
+		for( size_t i = 0; i < count; i++ ) {
+			results[i] = ClassifyToken( inputs[i].data(), inputs[i].size(),
+										raw );
+		}
+	}
+
 	/** -----------------------------------------------------------------------
 	 * Overload for Format.
 	 */
@@ -407,13 +512,13 @@ private:
 			if( lastslash == std::string::npos ) return SteamID();
 		}
 
-		if( CheckProfilePrefix( str, lastslash ) ) {
+		if( CheckProfilePrefix( str.c_str(), lastslash ) ) {
 			return Parse( str.substr( lastslash+1 ) );
 		}
 		return SteamID();
 	}
 
-	static bool CheckProfilePrefix( std::string &str, int end ) {
+	static bool CheckProfilePrefix( const char *str, int end ) {
 		// possible prefixes:
 		// 0123456789012345678901234567890123456789
 		// https://www.steamcommunity.com/profiles/
@@ -424,26 +529,195 @@ private:
 		// steamcommunity.com/profiles/
 
 		if( end == 39 ) {
-			return str.compare( 0, 1+end, 
-					"https://www.steamcommunity.com/profiles/" ) == 0;
+			return std::char_traits<char>::compare( str, 
+					"https://www.steamcommunity.com/profiles/", 1+end ) == 0;
 		} else if( end == 38 ) {
-			return str.compare( 0, 1+end, 
-					"http://www.steamcommunity.com/profiles/" ) == 0;
+			return std::char_traits<char>::compare( str, 
+					"http://www.steamcommunity.com/profiles/", 1+end ) == 0;
 		} else if( end == 35 ) {
-			return str.compare( 0, 1+end, 
-					"https://steamcommunity.com/profiles/" ) == 0;
+			return std::char_traits<char>::compare( str, 
+					"https://steamcommunity.com/profiles/", 1+end ) == 0;
 		} else if( end == 34 ) {
-			return str.compare( 0, 1+end, 
-					"http://steamcommunity.com/profiles/" ) == 0;
+			return std::char_traits<char>::compare( str, 
+					"http://steamcommunity.com/profiles/", 1+end ) == 0;
 		} else if( end == 31 ) {
-			return str.compare( 0, 1+end, 
-					"www.steamcommunity.com/profiles/" ) == 0;
+			return std::char_traits<char>::compare( str, 
+					"www.steamcommunity.com/profiles/", 1+end ) == 0;
 		} else if( end == 27 ) {
-			return str.compare( 0, 1+end, 
-					"steamcommunity.com/profiles/" ) == 0;
+			return std::char_traits<char>::compare( str, 
+					"steamcommunity.com/profiles/", 1+end ) == 0;
 		}
 		return false;
 	}
+
+	//-------------------------------------------------------------------------
+	static Classification ClassifyToken( const char *str, size_t size,
+										 bool detect_raw ) {
+		// keep the digit limits in step with the integer constants.
+		static_assert( DigitsValue( MaxValueDigits() ) == MAX_VALUE,
+					   "MaxValueDigits out of sync" );
+		static_assert( DigitsValue( SteamID64BaseDigits() ) == STEAMID64_BASE,
+					   "SteamID64BaseDigits out of sync" );
+		static_assert( DigitsValue( SteamID64MaxDigits() ) 
+						== STEAMID64_BASE + MAX_VALUE,
+					   "SteamID64MaxDigits out of sync" );
+		static_assert( DigitsValue( SteamID32EvenMaxDigits() ) 
+						== MAX_VALUE / 2,
+					   "SteamID32EvenMaxDigits out of sync" );
+		static_assert( DigitsValue( SteamID32OddMaxDigits() ) 
+						== (MAX_VALUE - 1) / 2,
+					   "SteamID32OddMaxDigits out of sync" );
+		static_assert( DigitsValue( S32NegativeMaxDigits() ) 
+						== 4294967296L - 1,
+					   "S32NegativeMaxDigits out of sync" );
+
+		Classification result = { 0, false };
+		if( size == 0 ) return result;
+
+		size_t start = 0, end = size;
+		while( start != end && std::isspace( (unsigned char)str[start] )) {
+			start++;
+		}
+		while( end != start && std::isspace( (unsigned char)str[end-1] )) {
+			end--;
+		}
+		const char *trimmed = str + start;
+		size_t length = end - start;
+
+		if( IsSteamID32( trimmed, length ) ) {
+			result.formats |= FormatBit( Formats::STEAMID32 );
+		}
+		if( IsSteamID64( trimmed, length ) ) {
+			result.formats |= FormatBit( Formats::STEAMID64 );
+		}
+		if( IsSteamID3( trimmed, length ) ) {
+			result.formats |= FormatBit( Formats::STEAMID3 );
+		}
+		if( IsProfileURL( trimmed, length ) ) {
+			result.formats |= PROFILE_URL;
+		}
+		result.valid = result.formats != 0;
+
+		uint raw = 0;
+		if( IsS32( str, size ) ) raw |= FormatBit( Formats::S32 );
+		if( IsRaw( str, size ) ) raw |= FormatBit( Formats::RAW );
+		if( raw && detect_raw ) result.valid = true;
+		result.formats |= raw;
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------------
+	// STEAM_X:Y:Z
+	static bool IsSteamID32( const char *str, size_t size ) {
+		if( size < 11  || str[0] != 'S' || str[1] != 'T' || str[2] != 'E'
+			|| str[3] != 'A' || str[4] != 'M' || str[5] != '_'
+			|| (str[6] != '0' && str[6] != '1') || str[7] != ':'
+			|| (str[8] != '0' && str[8] != '1') || str[9] != ':'
+			|| !IsDigitRun( str + 10, size - 10 ) ) return false;
+
+		// raw = Z*2 + Y, must be in (0, MAX_VALUE]
+		if( str[8] == '0' ) {
+			return InRange( str + 10, size - 10, "0", SteamID32EvenMaxDigits() );
+		}
+		return CompareDigits( str + 10, size - 10, 
+							  SteamID32OddMaxDigits() ) <= 0;
+	}
+
+	//-------------------------------------------------------------------------
+	// (STEAMID64_BASE, STEAMID64_BASE + MAX_VALUE]
+	static bool IsSteamID64( const char *str, size_t size ) {
+		return size != 0 && IsDigitRun( str, size ) 
+			&& InRange( str, size, SteamID64BaseDigits(), 
+						SteamID64MaxDigits() );
+	}
+
+	//-------------------------------------------------------------------------
+	// [U:1:xxxxxx]
+	static bool IsSteamID3( const char *str, size_t size ) {
+		if( size < 7   || str[0] != '[' || str[1] != 'U' || str[2] != ':'
+			|| str[3] != '1' || str[4] != ':' || str[size-1] != ']'
+			|| !IsDigitRun( str + 5, size - 6 ) ) return false;
+
+		return InRange( str + 5, size - 6, "0", MaxValueDigits() );
+	}
+
+	//-------------------------------------------------------------------------
+	// negative values wrap into the unsigned 32-bit range
+	static bool IsS32( const char *str, size_t size ) {
+		if( str[0] == '-' ) {
+			return size > 1 && IsDigitRun( str + 1, size - 1 )
+				&& InRange( str + 1, size - 1, "0", S32NegativeMaxDigits() );
+		}
+		return IsRaw( str, size );
+	}
+
+	//-------------------------------------------------------------------------
+	// (0, MAX_VALUE]
+	static bool IsRaw( const char *str, size_t size ) {
+		return size != 0 && IsDigitRun( str, size ) 
+			&& InRange( str, size, "0", MaxValueDigits() );
+	}
+
+	//-------------------------------------------------------------------------
+	// mirrors TryConvertProfileURL
+	static bool IsProfileURL( const char *str, size_t size ) {
+		if( size == 0 ) return false;
+		if( str[0] != 'h' && str[0] != 'w' && str[0] != 's' ) return false;
+
+		size_t lastslash = FindLastSlash( str, size );
+		if( lastslash == std::string::npos ) return false;
+		if( lastslash == size-1 ) {
+			size--;
+			lastslash = FindLastSlash( str, size );
+			if( lastslash == std::string::npos ) return false;
+		}
+
+		if( !CheckProfilePrefix( str, (int)lastslash ) ) return false;
+
+		return ClassifyToken( str + lastslash + 1, size - lastslash - 1,
+							  ParseRawDefault() ).valid;
+	}
+
+	//-------------------------------------------------------------------------
+	static size_t FindLastSlash( const char *str, size_t size ) {
+		while( size-- ) {
+			if( str[size] == '/' ) return size;
+		}
+		return std::string::npos;
+	}
+
+	//-------------------------------------------------------------------------
+	static bool IsDigitRun( const char *str, size_t size ) {
+		for( size_t i = 0; i != size; i++ ) {
+			if( str[i] < '0' || str[i] > '9' ) return false;
+		}
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	// compare a digit string against a decimal limit by length, then 
+	// lexically. leading zeros are ignored.
+	static int CompareDigits( const char *str, size_t size, 
+							  const char *limit ) {
+		while( size && *str == '0' ) {
+			str++;
+			size--;
+		}
+		size_t limit_size = std::char_traits<char>::length( limit );
+		if( size != limit_size ) return size < limit_size ? -1 : 1;
+		
+		int c = std::char_traits<char>::compare( str, limit, size );
+		return c < 0 ? -1 : c > 0 ? 1 : 0;
+	}
+
+	//-------------------------------------------------------------------------
+	// low < value <= high
+	static bool InRange( const char *str, size_t size, 
+						 const char *low, const char *high ) {
+		return CompareDigits( str, size, low ) > 0 
+			&& CompareDigits( str, size, high ) <= 0;
+	}
 };
 
 #endif
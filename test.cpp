@@ -5,6 +5,7 @@
 #include <chrono>
 
 #include "lib/steamid.hpp"
+#include "lib/steamid_cardinality.hpp"
 
 // ****************************************************************************
 void PrintLine( const std::string &text ) {
@@ -210,6 +211,129 @@ void RunTests() {
 			}
 		}
 	
+		return true;
+	})
+
+	// ************************************************************************
+	<< Test( "Cardinality sketch", [] {
+
+		const long long count = 100000;
+		SteamIDCardinality all, first, second;
+
+		PrintSubTest( "estimate" );
+		for( long long i = 1; i <= count; i++ ) {
+			all.AddRaw( i );
+			all.AddRaw( i ); // duplicates shouldn't count
+			(i & 1 ? first : second).AddRaw( i );
+		}
+		if( std::abs( all.Estimate() - count ) > 3 * all.ErrorBound() * count ) {
+			return false;
+		}
+
+		PrintSubTest( "bias (2.5m - 5m)" );
+		// average over several sketches so a bias shows up above the noise.
+		for( long long n = 41000; n <= 81000; n += 20000 ) {
+			const int runs = 20;
+			double error = 0.0;
+			for( int run = 0; run < runs; run++ ) {
+				SteamIDCardinality sketch;
+				for( long long i = 1; i <= n; i++ ) {
+					sketch.AddRaw( run * n + i );
+				}
+				error += (sketch.Estimate() - n) / n;
+			}
+			if( std::abs( error / runs ) > all.ErrorBound() ) return false;
+		}
+
+		PrintSubTest( "merge" );
+		if( !first.Merge( second ) ) return false;
+		if( first.Estimate() != all.Estimate() ) return false;
+		if( first.Merge( SteamIDCardinality( 10 ) ) ) return false;
+
+		PrintSubTest( "text" );
+		SteamIDCardinality text;
+		std::vector<std::string> inputs = { "STEAM_1:1:54499221", 
+			"76561198069264171", "[U:1:108998443]", "garbage", "" };
+		text.AddText( inputs );
+		if( std::floor( text.Estimate() + 0.5 ) != 1 ) return false;
+
+		PrintSubTest( "serialize" );
+		SteamIDCardinality loaded( 10 );
+		if( !loaded.Deserialize( all.Serialize() ) ) return false;
+		if( loaded.Precision() != all.Precision() ) return false;
+		if( loaded.Estimate() != all.Estimate() ) return false;
+		if( loaded.Deserialize( "SIDC" ) ) return false;
+
+		return true;
+	})
+
+	// ************************************************************************
+	<< Test( "Classification", [] {
+		
+		typedef SteamID::Formats F;
+
+		PrintSubTest( "formats" );
+		if( SteamID::Classify( "STEAM_1:1:54499221" ).formats 
+				!= SteamID::FormatBit( F::STEAMID32 ) ) return false;
+		if( SteamID::Classify( "76561198069264171" ).formats 
+				!= SteamID::FormatBit( F::STEAMID64 ) ) return false;
+		if( SteamID::Classify( "[U:1:108998443]" ).formats 
+				!= SteamID::FormatBit( F::STEAMID3 ) ) return false;
+		if( SteamID::Classify( "-5" ).formats 
+				!= SteamID::FormatBit( F::S32 ) ) return false;
+		if( SteamID::Classify( "108998443" ).formats 
+				!= (SteamID::FormatBit( F::S32 ) | SteamID::FormatBit( F::RAW )) ) {
+			return false;
+		}
+		if( SteamID::Classify( "steamcommunity.com/profiles/76561198069264171/" ).formats 
+				!= SteamID::PROFILE_URL ) return false;
+		if( SteamID::Classify( "108998443", false ).valid ) return false;
+
+		PrintSubTest( "stricter than Parse" );
+		for( const char *input : { "STEAM_1:0: 5", "STEAM_1:0:+5", 
+								   "STEAM_0:1:-0", "STEAM_1:0:5x" } ) {
+			if( SteamID::Classify( input ).valid ) return false;
+		}
+		if( SteamID::Classify( std::string( "[U:1:4\0x]", 9 ) ).valid ) {
+			return false;
+		}
+		if( SteamID::Classify( std::string( "76561198069264171\0junk", 22 ) ).valid ) {
+			return false;
+		}
+
+		PrintSubTest( "matches Parse" );
+		std::vector<std::string> inputs = { "", " ", "-0", "0", "00", 
+			"STEAM_0:0:0", "STEAM_0:1:0", "STEAM_1:0:34359738368", 
+			"STEAM_1:0:34359738369", "STEAM_1:1:34359738367", 
+			"STEAM_1:1:034359738367", "STEAM_1:1:34359738368", 
+			"STEAM_2:1:5", "76561197960265728", "76561197960265729", 
+			"76561266679742464", "76561266679742465", "076561266679742464",
+			"99999999999999999999999", "[U:1:0]", "[U:1:68719476736]", 
+			"[U:1:68719476737]", "[U:1:]", "[U:1:1a]", "68719476736", 
+			"68719476737", "-4294967295", "-4294967296", " 123", "123 ",
+			"1 2", " [U:1:5] ", "http://steamcommunity.com/profiles/[U:1:5]",
+			"http://steamcommunity.com/profiles/", "steamcommunity.com/id/5",
+			"https://www.steamcommunity.com/profiles/5", "\xff" "12" };
+		
+		for( int i = 0; i < 2000; i++ ) {
+			SteamID steamid( random( 1, SteamID::MAX_VALUE ) );
+			inputs.push_back( steamid[ (F)random( 1, 5 ) ] );
+		}
+
+		std::vector<SteamID::Classification> results( inputs.size() );
+		for( int detect_raw = 0; detect_raw < 2; detect_raw++ ) {
+			SteamID::ClassifyBatch( inputs.data(), inputs.size(), 
+									results.data(), detect_raw );
+			for( size_t i = 0; i < inputs.size(); i++ ) {
+				bool parsed = !SteamID::Parse( inputs[i], F::AUTO, 
+											   detect_raw ).Empty();
+				if( results[i].valid != parsed ) {
+					PrintSubTest( "failure: " + inputs[i] );
+					return false;
+				}
+			}
+		}
+
 		return true;
 	});
 	// ************************************************************************